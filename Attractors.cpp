@@ -86,6 +86,16 @@ BDD Attractors::representPrimeVariables() const {
     return bdd;
 }
 
+// the intermediate variables are only needed for composing relations, so they are added to the manager on first use
+BDD Attractors::representIntermediateVariables() const {
+    BDD bdd = manager.bddOne();
+    for (int i = numUnprimedBDDVars * 2; i < numUnprimedBDDVars * 3; i++) {
+        BDD var = manager.bddVar(i);
+        bdd *= var;
+    }
+    return bdd;
+}
+
 inline int Attractors::countBits(int end) const {
     auto lambda = [](int a, int b) { return a + bits(b); };
     return std::accumulate(ranges.begin(), ranges.begin() + end, 0, lambda);
@@ -135,6 +145,14 @@ BDD Attractors::representStateQN(const std::vector<int>& vars, const std::vector
     return bdd;
 }
 
+BDD Attractors::representConcreteStateQN(const std::vector<int>& state) const {
+    BDD bdd = manager.bddOne();
+    for (int var = 0; var < state.size(); var++) {
+        bdd *= representUnprimedVarQN(var, state[var]);
+    }
+    return bdd;
+}
+
 BDD Attractors::varDoesChangeQN(int var) const {
     int start = countBits(var);
     int numBits = bits(ranges[var]);
@@ -215,10 +233,11 @@ BDD Attractors::representAsyncQNTransitionRelation() const {
 }
 
 BDD Attractors::renameRemovingPrimes(const BDD& bdd) const {
-    int *permute = new int[numUnprimedBDDVars * 2];
+    int *permute = new int[numUnprimedBDDVars * 3];
     for (int i = 0; i < numUnprimedBDDVars; i++) {
         permute[i] = i;
         permute[i + numUnprimedBDDVars] = i;
+        permute[i + numUnprimedBDDVars * 2] = i + numUnprimedBDDVars * 2;
     }
     BDD r = bdd.Permute(permute);
     delete[] permute;
@@ -226,10 +245,11 @@ BDD Attractors::renameRemovingPrimes(const BDD& bdd) const {
 }
 
 BDD Attractors::renameAddingPrimes(const BDD& bdd) const {
-    int *permute = new int[numUnprimedBDDVars * 2];
+    int *permute = new int[numUnprimedBDDVars * 3];
     for (int i = 0; i < numUnprimedBDDVars; i++) {
         permute[i] = i + numUnprimedBDDVars;
         permute[i + numUnprimedBDDVars] = i + numUnprimedBDDVars;
+        permute[i + numUnprimedBDDVars * 2] = i + numUnprimedBDDVars * 2;
     }
 
     BDD r = bdd.Permute(permute);
@@ -237,8 +257,41 @@ BDD Attractors::renameAddingPrimes(const BDD& bdd) const {
     return r;
 }
 
+BDD Attractors::renamePrimesToIntermediates(const BDD& bdd) const {
+    int *permute = new int[numUnprimedBDDVars * 3];
+    for (int i = 0; i < numUnprimedBDDVars; i++) {
+        permute[i] = i;
+        permute[i + numUnprimedBDDVars] = i + numUnprimedBDDVars * 2;
+        permute[i + numUnprimedBDDVars * 2] = i + numUnprimedBDDVars * 2;
+    }
+
+    BDD r = bdd.Permute(permute);
+    delete[] permute;
+    return r;
+}
+
+BDD Attractors::renameUnprimedToIntermediates(const BDD& bdd) const {
+    int *permute = new int[numUnprimedBDDVars * 3];
+    for (int i = 0; i < numUnprimedBDDVars; i++) {
+        permute[i] = i + numUnprimedBDDVars * 2;
+        permute[i + numUnprimedBDDVars] = i + numUnprimedBDDVars;
+        permute[i + numUnprimedBDDVars * 2] = i + numUnprimedBDDVars * 2;
+    }
+
+    BDD r = bdd.Permute(permute);
+    delete[] permute;
+    return r;
+}
+
+// relates x to x' whenever first takes x to some y and second takes y to x'
+BDD Attractors::composeRelations(const BDD& first, const BDD& second, const BDD& intermediateVariables) const {
+    BDD a = renamePrimesToIntermediates(first);
+    BDD b = renameUnprimedToIntermediates(second);
+    return a.AndAbstract(b, intermediateVariables);
+}
+
 BDD Attractors::randomState(const BDD& S) const {
-    char *out = new char[numUnprimedBDDVars * 2];
+    char *out = new char[manager.ReadSize()];
     S.PickOneCube(out);
     std::vector<bool> values;
     for (int i = 0; i < numUnprimedBDDVars; i++) {
@@ -253,6 +306,145 @@ BDD Attractors::randomState(const BDD& S) const {
     return representState(values);
 }
 
+std::vector<int> Attractors::randomStateQN(const BDD& S) const {
+    char *out = new char[manager.ReadSize()];
+    S.PickOneCube(out);
+    std::vector<int> state;
+    int i = 0;
+    for (int range : ranges) {
+        int b = bits(range);
+        int val = 0;
+        for (int n = 0; n < b; n++) {
+            if (out[i + n] != 0) {
+                val |= 1 << n;
+            }
+        }
+        state.push_back(val);
+        i += b;
+    }
+    delete[] out;
+    return state;
+}
+
+// for each variable, the target value for every combination of its inputs, indexed in mixed radix
+std::vector<std::vector<int>> Attractors::buildLookupTablesQN() const {
+    std::vector<std::vector<int>> tables(ranges.size());
+    for (int v = 0; v < ranges.size(); v++) {
+        if (ranges[v] > 0) {
+            const auto& iVars = qn.inputVars[v];
+            const auto& iValues = qn.inputValues[v];
+            const auto& oValues = qn.outputValues[v];
+
+            int size = 1;
+            for (int input : iVars) {
+                size *= ranges[input] + 1;
+            }
+            tables[v] = std::vector<int>(size, -1); // -1 where the table has no row for an input combination
+
+            for (int i = 0; i < oValues.size(); i++) {
+                int index = 0;
+                int stride = 1;
+                for (int j = 0; j < iVars.size(); j++) {
+                    index += iValues[i][j] * stride;
+                    stride *= ranges[iVars[j]] + 1;
+                }
+                tables[v][index] = oValues[i];
+            }
+        }
+    }
+    return tables;
+}
+
+// for each variable, the variables whose target value depends on it
+std::vector<std::vector<int>> Attractors::buildDependentsQN() const {
+    std::vector<std::vector<int>> deps(ranges.size());
+    for (int v = 0; v < ranges.size(); v++) {
+        if (ranges[v] > 0) {
+            for (int input : qn.inputVars[v]) {
+                deps[input].push_back(v);
+            }
+        }
+    }
+    return deps;
+}
+
+int Attractors::targetValueQN(int var, const std::vector<int>& state) const {
+    if (ranges[var] == 0) return state[var];
+
+    const auto& iVars = qn.inputVars[var];
+    int index = 0;
+    int stride = 1;
+    for (int input : iVars) {
+        index += state[input] * stride;
+        stride *= ranges[input] + 1;
+    }
+    return lookupTables[var][index];
+}
+
+// walks explicitly from state for at most steps updates, stopping early once the walk is known to be inside an attractor
+void Attractors::simulateQN(std::vector<int>& state, bool synchronous, int steps, std::mt19937& rng) const {
+    if (synchronous) {
+        // Brent's cycle detection: compare against a checkpoint taken at increasing powers of two
+        std::vector<int> checkpoint(state);
+        std::vector<int> next(state.size());
+        int power = 1;
+        int length = 0;
+        for (int step = 0; step < steps; step++) {
+            for (int v = 0; v < ranges.size(); v++) {
+                int val = targetValueQN(v, state);
+                if (val < 0) return; // no successor in the table, leave it to the symbolic check
+                next[v] = val;
+            }
+            state.swap(next);
+            if (state == checkpoint) return;
+
+            length++;
+            if (length == power) {
+                checkpoint = state;
+                power *= 2;
+                length = 0;
+            }
+        }
+    }
+    else {
+        std::vector<int> updatable;
+        for (int v = 0; v < ranges.size(); v++) {
+            if (ranges[v] > 0) updatable.push_back(v);
+        }
+        if (updatable.empty()) return;
+
+        // running count of variables not yet at their target, so a fixpoint is noticed without rescanning
+        std::vector<bool> unsettled(ranges.size(), false);
+        int numUnsettled = 0;
+        for (int v : updatable) {
+            if (targetValueQN(v, state) != state[v]) {
+                unsettled[v] = true;
+                numUnsettled++;
+            }
+        }
+
+        std::uniform_int_distribution<size_t> pick(0, updatable.size() - 1);
+        for (int step = 0; step < steps && numUnsettled > 0; step++) {
+            int v = updatable[pick(rng)];
+            if (!unsettled[v]) continue;
+
+            int val = targetValueQN(v, state);
+            if (val < 0) return;
+            state[v] = val;
+            unsettled[v] = false;
+            numUnsettled--;
+
+            for (int d : dependents[v]) {
+                bool u = targetValueQN(d, state) != state[d];
+                if (u != unsettled[d]) {
+                    unsettled[d] = u;
+                    numUnsettled += u ? 1 : -1;
+                }
+            }
+        }
+    }
+}
+
 void Attractors::removeInvalidBitCombinations(BDD& S) const {
     for (int var = 0; var < ranges.size(); var++) {
         if (ranges[var] > 0) {
@@ -313,29 +505,88 @@ BDD Attractors::fixpoints(const BDD& syncTransitionBdd) const {
     return bdd;
 }
 
-std::list<BDD> Attractors::attractors(const BDD& transitionBdd, const BDD& statesToRemove) const {
+std::list<BDD> Attractors::attractors(const BDD& transitionBdd, const BDD& statesToRemove, bool synchronous) const {
     std::list<BDD> attractors;
     BDD S = manager.bddOne();
     removeInvalidBitCombinations(S);
     S *= !statesToRemove;
 
-    while (!S.IsZero()) {
-        BDD s = randomState(S);
+    std::mt19937 rng; // default seed, so runs are reproducible
+    // doubled every time a walk fails to reach an attractor, halved every time one succeeds
+    const int minSteps = ranges.size();
+    const int maxSteps = 1024 * ranges.size();
+    int steps = minSteps;
+    int walks = 0;
+    int hits = 0;
 
-        for (int i = 0; i < ranges.size(); i++) { // unrolling by ranges.size() may not be the perfect choice of number
-            BDD sP = immediateSuccessorStates(transitionBdd, s);
-            s = randomState(sP);
-        }
+    while (!S.IsZero()) {
+        std::vector<int> state = randomStateQN(S);
+        simulateQN(state, synchronous, steps, rng);
+        BDD s = representConcreteStateQN(state);
 
         BDD fr = forwardReachableStates(transitionBdd, s);
         BDD br = backwardReachableStates(transitionBdd, s);
 
+        walks++;
         if ((fr * !br).IsZero()) {
             attractors.push_back(fr);
+            hits++;
+            steps = std::max(steps / 2, minSteps);
+        }
+        else {
+            steps = std::min(steps * 2, maxSteps);
         }
 
         S *= !(s + br);
     }
+
+    if (walks > 0) {
+        std::cout << (synchronous ? "Synchronous" : "Asynchronous") << " simulation reached an attractor in " << hits << " of " << walks << " walks (final step budget " << steps << ")" << std::endl;
+    }
+    return attractors;
+}
+
+// every state has exactly one successor, so cycles are found by iterative squaring of the transition relation
+std::list<BDD> Attractors::syncAttractors(const BDD& syncTransitionBdd, const BDD& statesToRemove) const {
+    BDD valid = manager.bddOne();
+    removeInvalidBitCombinations(valid);
+    BDD S = valid * !statesToRemove;
+
+    std::list<BDD> attractors;
+    if (S.IsZero()) return attractors;
+
+    // if no remaining state leads into statesToRemove (e.g. the basins of the fixpoints), S is closed forwards,
+    // so its own image shrinks monotonically and transients ending in removed states need not be walked off
+    bool closed = (immediatePredecessorStates(syncTransitionBdd, statesToRemove) * S).IsZero();
+
+    BDD intermediateVariables = representIntermediateVariables();
+    // powers[k] takes each state to its successor 2^k steps later
+    std::vector<BDD> powers{ syncTransitionBdd };
+    BDD cyclic = closed ? S : valid;
+    while (true) {
+        // after n squarings both sets have taken 2^n - 1 steps; once the image of cyclic stops shrinking,
+        // every transient has been walked off and S holds at least one state from each cycle it can reach
+        BDD next = immediateSuccessorStates(powers.back(), cyclic);
+        S = closed ? next : immediateSuccessorStates(powers.back(), S);
+        if (next == cyclic) break;
+        cyclic = next;
+        powers.push_back(composeRelations(powers.back(), powers.back(), intermediateVariables));
+    }
+
+    while (!S.IsZero()) {
+        // doubles the number of steps taken from s each time, until the cycle stops growing
+        BDD cycle = randomState(S);
+        for (int k = 0; ; k++) {
+            if (k == powers.size()) powers.push_back(composeRelations(powers.back(), powers.back(), intermediateVariables));
+            BDD reached = cycle + immediateSuccessorStates(powers[k], cycle);
+            if (reached == cycle) break;
+            cycle = reached;
+        }
+
+        std::cout << "Attractor" << attractors.size() << " has period " << static_cast<long long>(cycle.CountMinterm(numUnprimedBDDVars)) << std::endl;
+        attractors.push_back(cycle);
+        S *= !cycle;
+    }
     return attractors;
 }
 
@@ -345,9 +596,9 @@ bool Attractors::isAsyncLoop(const BDD &S, const BDD& syncTransitionBdd) const {
 
     while (!s.IsZero()) {
         BDD sP = immediateSuccessorStates(syncTransitionBdd, s); // sync, so should be one state
-        char *sCube = new char[numUnprimedBDDVars * 2];
+        char *sCube = new char[manager.ReadSize()];
         s.PickOneCube(sCube);
-        char *sPCube = new char[numUnprimedBDDVars * 2];
+        char *sPCube = new char[manager.ReadSize()];
         sP.PickOneCube(sPCube);
 
         int nVarDiff = 0;
@@ -452,7 +703,7 @@ int Attractors::runSync(const BDD& initialStates, const std::string& outputFile,
     }
 
     std::cout << "Finding attractors..." << std::endl;
-    std::list<BDD> syncLoops = attractors(syncTransitionBdd, statesToRemove);
+    std::list<BDD> syncLoops = syncAttractors(syncTransitionBdd, statesToRemove);
 
     int i = 0;
     for (const BDD& attractor : syncLoops) {
@@ -489,7 +740,7 @@ int Attractors::runAsync(const BDD& initialStates, const std::string& outputFile
     }
 
     std::cout << "Finding attractors..." << std::endl;
-    std::list<BDD> syncLoops = attractors(syncTransitionBdd, statesToRemove);
+    std::list<BDD> syncLoops = attractors(syncTransitionBdd, statesToRemove, true);
 
     std::cout << "Building asynchronous transition relation..." << std::endl;
     BDD asyncTransitionBdd = representAsyncQNTransitionRelation();
@@ -505,7 +756,7 @@ int Attractors::runAsync(const BDD& initialStates, const std::string& outputFile
     }
 
     BDD br = syncAsyncAttractors + backwardReachableStates(asyncTransitionBdd, syncAsyncAttractors);
-    asyncLoops.splice(asyncLoops.end(), attractors(asyncTransitionBdd, br));
+    asyncLoops.splice(asyncLoops.end(), attractors(asyncTransitionBdd, br, false));
     int i = 0;
     for (const BDD& attractor : asyncLoops) {
         std::ofstream file(outputFile + "Attractor" + std::to_string(i) + ".csv");
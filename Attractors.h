@@ -16,6 +16,8 @@ class Attractors {
     const std::vector<int> minValues;
     const std::vector<int> ranges;
     const QNTable qn;
+    const std::vector<std::vector<int>> lookupTables;
+    const std::vector<std::vector<int>> dependents;
     const int numUnprimedBDDVars;
     const Cudd manager;
     const BDD nonPrimeVariables;
@@ -24,30 +26,41 @@ class Attractors {
     BDD representState(const std::vector<bool>& values) const;
     BDD representNonPrimeVariables() const;
     BDD representPrimeVariables() const;
+    BDD representIntermediateVariables() const;
     int countBits(int end) const;
     BDD representUnprimedVarQN(int var, int val) const;
     BDD representPrimedVarQN(int var, int val) const;
     BDD representStateQN(const std::vector<int>& vars, const std::vector<int>& values) const;
+    BDD representConcreteStateQN(const std::vector<int>& state) const;
     BDD varDoesChangeQN(int var) const;
     BDD otherVarsDoNotChangeQN(int var) const;
     BDD representSyncQNTransitionRelation() const;
     BDD representAsyncQNTransitionRelation() const;
     BDD renameRemovingPrimes(const BDD& bdd) const;
     BDD renameAddingPrimes(const BDD& bdd) const;
+    BDD renamePrimesToIntermediates(const BDD& bdd) const;
+    BDD renameUnprimedToIntermediates(const BDD& bdd) const;
+    BDD composeRelations(const BDD& first, const BDD& second, const BDD& intermediateVariables) const;
     BDD randomState(const BDD& S) const;
+    std::vector<int> randomStateQN(const BDD& S) const;
+    std::vector<std::vector<int>> buildLookupTablesQN() const;
+    std::vector<std::vector<int>> buildDependentsQN() const;
+    int targetValueQN(int var, const std::vector<int>& state) const;
+    void simulateQN(std::vector<int>& state, bool synchronous, int steps, std::mt19937& rng) const;
     void removeInvalidBitCombinations(BDD& S) const;
     BDD immediateSuccessorStates(const BDD& transitionBdd, const BDD& valuesBdd) const;
     BDD forwardReachableStates(const BDD& transitionBdd, const BDD& valuesBdd) const;
     BDD immediatePredecessorStates(const BDD& transitionBdd, const BDD& valuesBdd) const;
     BDD backwardReachableStates(const BDD& transitionBdd, const BDD& valuesBdd) const;
     BDD fixpoints(const BDD& transitionBdd) const;
-    std::list<BDD> attractors(const BDD& transitionBdd, const BDD& statesToRemove) const;
+    std::list<BDD> attractors(const BDD& transitionBdd, const BDD& statesToRemove, bool synchronous) const;
+    std::list<BDD> syncAttractors(const BDD& syncTransitionBdd, const BDD& statesToRemove) const;
     bool isAsyncLoop(const BDD& S, const BDD& syncTransitionBdd) const;
     std::string prettyPrint(const BDD& attractor) const;
 
 public:
     Attractors(std::vector<int>&& minVals, std::vector<int>&& rangesV, QNTable&& qnT) :
-        minValues(std::move(minVals)), ranges(std::move(rangesV)), qn(std::move(qnT)),
+        minValues(std::move(minVals)), ranges(std::move(rangesV)), qn(std::move(qnT)), lookupTables(buildLookupTablesQN()), dependents(buildDependentsQN()),
         numUnprimedBDDVars(countBits(minValues.size())),
         manager(numUnprimedBDDVars * 2),
         nonPrimeVariables(representNonPrimeVariables()), primeVariables(representPrimeVariables())
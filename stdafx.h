@@ -20,3 +20,4 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <random>